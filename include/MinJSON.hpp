@@ -6,53 +6,66 @@
 #endif
 
 #include <any>
+#include <bitset>
 #include <charconv>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <cctype>
-#include <format>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <optional>
+#include <span>
 #include <regex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <algorithm>
 
-/**
- * @brief Концепт поддерживаемых типов значений
- */
-template <typename T>
-concept MinJSONValueType =
-    std::same_as<T, int> ||
-    std::same_as<T, double> ||
-    std::same_as<T, bool> ||
-    std::same_as<T, std::string> ||
-    std::same_as<T, std::nullptr_t> ||
-    requires(T vec) {
-        requires std::same_as<T, std::vector<typename T::value_type>>;
-        requires MinJSONValueType<typename T::value_type>;
-    } ||
-    requires(T opt) {
-        requires std::same_as<T, std::optional<typename T::value_type>>;
-        requires MinJSONValueType<typename T::value_type>;
-    };
-
-namespace MinJSON::detail {
+// Имя MinJSON занято классом, поэтому вспомогательное пространство имён отдельное
+namespace MinJSONDetail {
     template <typename T> struct is_vector : std::false_type {};
     template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
     
     template <typename T> struct is_optional : std::false_type {};
     template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+    
+    // Концепт не может ссылаться сам на себя, поэтому рекурсия вынесена в трейт
+    template <typename T> struct is_value_type : std::bool_constant<
+        std::same_as<T, int> ||
+        std::same_as<T, double> ||
+        std::same_as<T, bool> ||
+        std::same_as<T, std::string> ||
+        std::same_as<T, std::nullptr_t>> {};
+    template <typename T> struct is_value_type<std::vector<T>> : is_value_type<T> {};
+    template <typename T> struct is_value_type<std::optional<T>> : is_value_type<T> {};
+    
+    // Хеш для поиска в std::unordered_map<std::string, ...> по string_view без копирования ключа
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const noexcept {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
 }
 
+/**
+ * @brief Концепт поддерживаемых типов значений
+ */
+template <typename T>
+concept MinJSONValueType = MinJSONDetail::is_value_type<T>::value;
+
 /**
  * @brief Высокопроизводительная JSON-библиотека для C++20
  */
@@ -61,18 +74,82 @@ public:
     using Value = std::any;
     using Object = std::unordered_map<std::string, Value>;
     using Array = std::vector<Value>;
-    using Error = std::string;
+    // Массивы из одних чисел разбираются в IntArray/DoubleArray, а не в Array:
+    // вместо std::any_cast<Array> используйте get<std::vector<T>>() или get_span<T>()
+    using IntArray = std::vector<int>;       // упакованный массив целых чисел
+    using DoubleArray = std::vector<double>; // упакованный массив чисел с плавающей точкой
+    
+    /**
+     * @brief Компактная ошибка: код и смещение в байтах
+     *
+     * Не выделяет память и не требует исключений. Строка и столбец
+     * вычисляются только по запросу через location().
+     */
+    struct Error {
+        enum class Code : std::uint8_t {
+            UnexpectedCharacter,
+            ExpectedNull,
+            ExpectedBoolean,
+            ExpectedQuote,
+            IncompleteUnicodeEscape,
+            UnterminatedString,
+            InvalidNumber,
+            ExpectedArrayDelimiter,
+            ExpectedColon,
+            ExpectedObjectDelimiter,
+            UnexpectedEndOfInput,
+            TrailingCharacters,
+            SchemaType,
+            SchemaEnum,
+            SchemaMinimum,
+            SchemaMaximum,
+            SchemaMinLength,
+            SchemaMaxLength,
+            SchemaMinItems,
+            SchemaMaxItems,
+            SchemaPattern,
+            SchemaPatternInputTooLong,
+            SchemaRequired,
+            InvalidSchema,
+            InvalidSchemaPattern,
+            InvalidPath,
+            PathNotFound,
+            ExpectedObject,
+            ExpectedArray,
+            IndexOutOfRange,
+            Internal
+        };
+        
+        struct Location {
+            size_t line;   // с 1
+            size_t column; // с 1, в байтах
+        };
+        
+        Code code = Code::Internal;
+        size_t offset = 0; // во входном документе (или в пути для ошибок доступа)
+        
+        [[nodiscard]] std::string_view message() const noexcept;
+        [[nodiscard]] Location location(std::string_view input) const noexcept;
+        
+        friend bool operator==(const Error&, const Error&) = default;
+        friend std::ostream& operator<<(std::ostream& os, const Error& error) {
+            return os << error.message() << " at offset " << error.offset;
+        }
+    };
     
     template <typename T> using Result = std::variant<T, Error>;
 
+    // offset — позиция сегмента в строке пути, для ошибок доступа
     struct KeySegment {
         std::string value;
-        KeySegment(std::string s) : value(std::move(s)) {}
+        size_t offset;
+        KeySegment(std::string s, size_t o = 0) : value(std::move(s)), offset(o) {}
     };
     
     struct IndexSegment {
         size_t value;
-        IndexSegment(size_t i) : value(i) {}
+        size_t offset;
+        IndexSegment(size_t i, size_t o = 0) : value(i), offset(o) {}
     };
     
     using PathSegment = std::variant<KeySegment, IndexSegment>;
@@ -84,6 +161,65 @@ public:
     };
     
     using ReflectionRegistry = std::unordered_map<std::string, std::shared_ptr<Reflector>>;
+    
+    /**
+     * @brief Скомпилированная схема (подмножество JSON Schema)
+     *
+     * Поддерживаются ключевые слова type, required, properties, items, enum,
+     * minimum, maximum, minLength, maxLength, minItems, maxItems и pattern.
+     *
+     * В отличие от JSON Schema, строки длиннее pattern_max_input по pattern
+     * не проверяются: сопоставитель std::regex рекурсивен и на длинных строках
+     * переполняет стек. Такая строка отклоняется (SchemaPatternInputTooLong)
+     * или, если задан skip_long_pattern_input, принимается без проверки.
+     */
+    struct Schema {
+        enum TypeMask : unsigned {
+            NullType    = 1u << 0,
+            BooleanType = 1u << 1,
+            IntegerType = 1u << 2,
+            NumberType  = 1u << 3,
+            StringType  = 1u << 4,
+            ArrayType   = 1u << 5,
+            ObjectType  = 1u << 6
+        };
+        
+        unsigned types = 0; // 0 — любой тип
+        std::unordered_map<std::string, std::shared_ptr<Schema>> properties;
+        std::vector<std::string> required;
+        std::shared_ptr<Schema> items;
+        Array enum_values;
+        std::optional<double> minimum;
+        std::optional<double> maximum;
+        std::optional<size_t> min_length;
+        std::optional<size_t> max_length;
+        std::optional<size_t> min_items;
+        std::optional<size_t> max_items;
+        std::optional<std::regex> pattern;
+        
+        // Запас в несколько раз для шаблонов с альтернативой под `*` на стеке 8 МиБ
+        static constexpr size_t default_pattern_max_input = 4 * 1024;
+        size_t pattern_max_input = default_pattern_max_input;
+        bool skip_long_pattern_input = false;
+    };
+    
+    /**
+     * @brief Скомпилированная проекция: префиксное дерево запрошенных путей
+     *
+     * Пути записываются в синтаксисе get() и дополнительно допускают
+     * `[*]` — любой элемент массива.
+     *
+     * Пропускаемые значения проверяются не полностью: для строк — только
+     * закрывающая кавычка, для контейнеров — только парность скобок. Поэтому
+     * parse() с проекцией может принять документ, который parse() без неё
+     * отклонит (например, `{"skipped": {,,}, "a": 1}`).
+     */
+    struct Projection {
+        bool terminal = false; // поддерево входит в результат целиком
+        std::map<std::string, std::shared_ptr<Projection>, std::less<>> keys;
+        std::map<size_t, std::shared_ptr<Projection>> indices;
+        std::shared_ptr<Projection> any_index; // [*]
+    };
 
     MinJSON() {
         register_builtin_types();
@@ -91,8 +227,23 @@ public:
 
     // Парсинг и сериализация
     [[nodiscard]] Result<Value> parse(std::string_view input) noexcept;
+    [[nodiscard]] Result<Value> parse(std::string_view input, const Schema& schema) noexcept;
+    [[nodiscard]] Result<Value> parse_parallel(std::string_view input, size_t threads = 0) noexcept;
+    [[nodiscard]] Result<Value> parse(std::string_view input, const Projection& projection) noexcept;
     [[nodiscard]] std::string stringify(const Value& value, bool pretty = false) const noexcept;
     
+    class StreamParser;
+    
+    // Схемы
+    [[nodiscard]] Result<Schema> compile_schema(
+        const Value& schema,
+        size_t pattern_max_input = Schema::default_pattern_max_input,
+        bool skip_long_pattern_input = false
+    ) const noexcept;
+    
+    // Проекции
+    [[nodiscard]] Result<Projection> compile_projection(const std::vector<std::string_view>& paths) const noexcept;
+    
     // Доступ к данным
     template <MinJSONValueType T>
     [[nodiscard]] T get(const Value& root, std::string_view path, const T& default_val = {}) const noexcept;
@@ -100,6 +251,11 @@ public:
     template <MinJSONValueType T>
     [[nodiscard]] Result<T> get_checked(const Value& root, std::string_view path) const noexcept;
     
+    // Представление упакованного числового массива без копирования
+    template <typename T>
+        requires std::same_as<T, int> || std::same_as<T, double>
+    [[nodiscard]] std::span<const T> get_span(const Value& root, std::string_view path) const noexcept;
+    
     [[nodiscard]] std::optional<Error> set(Value& root, std::string_view path, Value value) noexcept;
     
     // Рефлексия
@@ -122,49 +278,239 @@ private:
     
     static inline thread_local std::unordered_map<
         std::string, 
-        std::vector<PathSegment>
+        std::vector<PathSegment>,
+        MinJSONDetail::StringHash,
+        std::equal_to<>
     > path_cache_;
     
     ReflectionRegistry reflection_registry_;
+    
+    // Меньшие диапазоны не окупают запуск потока
+    static constexpr size_t parallel_min_range_ = 1 << 20;
+    
+    // Глубина, до которой skip_value() проверяет парность скобок без выделения памяти
+    static constexpr size_t skip_max_depth_ = 1024;
+    
+    class ArrayBuilder;
 
     // Вспомогательные методы
     void skip_whitespace() noexcept;
     char peek() const noexcept;
     char consume() noexcept;
     
-    [[nodiscard]] Result<Value> parse_value();
+    [[nodiscard]] Result<Value> parse_value(const Schema* schema = nullptr);
     [[nodiscard]] Result<Value> parse_null();
     [[nodiscard]] Result<Value> parse_bool();
     [[nodiscard]] Result<Value> parse_string();
     [[nodiscard]] Result<Value> parse_number();
-    [[nodiscard]] Result<Value> parse_array();
-    [[nodiscard]] Result<Value> parse_object();
+    [[nodiscard]] Result<Value> parse_array(const Schema* schema);
+    [[nodiscard]] Result<Value> parse_object(const Schema* schema);
+    [[nodiscard]] std::optional<Error> parse_member(Object& result, const Schema* schema);
+    
+    template <typename OnSplit>
+    static void find_split_points(std::string_view input, size_t begin, size_t parts, OnSplit&& on_split);
+    [[nodiscard]] std::optional<Error> parse_range(
+        std::string_view input,
+        size_t from,
+        size_t to,
+        bool is_last,
+        Object* object,
+        ArrayBuilder* array
+    );
+    
+    [[nodiscard]] std::optional<Error> compile_schema_node(const Value& schema, Schema& result) const;
+    [[nodiscard]] std::optional<Error::Code> validate_start(const Schema& schema, char c) const noexcept;
+    [[nodiscard]] std::optional<Error::Code> validate_scalar(const Schema& schema, const Value& value) const noexcept;
+    [[nodiscard]] static bool scalar_equals(const Value& lhs, const Value& rhs) noexcept;
+    
+    [[nodiscard]] Result<Value> parse_projected(const Projection& projection);
+    [[nodiscard]] std::optional<Error> skip_value() noexcept;
+    [[nodiscard]] std::optional<Error> skip_string() noexcept;
+    static void merge_projection(Projection& target, const Projection& source);
+    static void expand_wildcards(Projection& projection);
     
     [[nodiscard]] std::string quote_string(std::string_view str) const noexcept;
     [[nodiscard]] std::string stringify_array(const Array& arr, bool pretty) const noexcept;
+    template <typename T>
+    [[nodiscard]] std::string stringify_packed(const std::vector<T>& arr) const noexcept;
     [[nodiscard]] std::string stringify_object(const Object& obj, bool pretty) const noexcept;
     
     void register_builtin_types() noexcept;
     [[nodiscard]] std::optional<Value> reflect_to_json(const Value& value) const noexcept;
     
-    [[nodiscard]] std::vector<PathSegment> parse_path(std::string_view path) const;
-    [[nodiscard]] const Value* find_value(const Value& root, std::string_view path) const noexcept;
-    [[nodiscard]] const Value* traverse_path(const Value* current, const std::vector<PathSegment>& segments) const noexcept;
+    template <typename OnKey, typename OnIndex>
+    [[nodiscard]] static std::optional<Error> scan_path(std::string_view path, OnKey&& on_key, OnIndex&& on_index);
+    [[nodiscard]] Result<const std::vector<PathSegment>*> parse_path(std::string_view path) const;
+    [[nodiscard]] const Value* find_value(const Value& root, std::string_view path, Value& element) const noexcept;
+    [[nodiscard]] const Value* traverse_path(
+        const Value* current,
+        const std::vector<PathSegment>& segments,
+        Value& element,
+        Error* error = nullptr
+    ) const noexcept;
+    [[nodiscard]] static std::optional<Array> unpack_array(const Value& value);
     
     template <MinJSONValueType T>
     [[nodiscard]] T extract_value(const Value& value, const T& default_val) const noexcept;
     
     void handle_segment(Value& node, const KeySegment& seg, bool is_last);
     void handle_segment(Value& node, const IndexSegment& seg, bool is_last);
-    void advance(Value*& current, const KeySegment& seg);
-    void advance(Value*& current, const IndexSegment& seg);
+    [[nodiscard]] std::optional<Error> advance(Value*& current, const KeySegment& seg) noexcept;
+    [[nodiscard]] std::optional<Error> advance(Value*& current, const IndexSegment& seg) noexcept;
     
     // Утилиты
+    [[nodiscard]] Error make_error(Error::Code code) const noexcept {
+        return Error{code, pos_};
+    }
+    [[nodiscard]] Result<Value> finish_document(Result<Value> result) noexcept;
     [[nodiscard]] static bool is_digit(char c) noexcept;
+    [[nodiscard]] static bool is_number_char(char c) noexcept;
     [[nodiscard]] static bool is_whitespace(char c) noexcept;
     [[nodiscard]] static std::string to_lower(std::string str) noexcept;
 };
 
+/**
+ * @brief Построитель массива, упаковывающий однородные числовые массивы
+ *
+ * Пока все элементы — числа, они хранятся в IntArray или DoubleArray
+ * (целые повышаются до double при первом дробном элементе). Первый
+ * нечисловой элемент переводит массив в обычный Array с исходными типами.
+ */
+class MinJSON::ArrayBuilder {
+public:
+    void push(Value value);
+    
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+    
+    // Дописывает элементы other так, как если бы они были переданы в push()
+    void append(ArrayBuilder&& other);
+    
+    [[nodiscard]] Value finish();
+
+private:
+    enum class Kind { Empty, Ints, Doubles, Generic };
+    
+    Kind kind_ = Kind::Empty;
+    size_t size_ = 0;
+    IntArray ints_;
+    DoubleArray doubles_;
+    std::vector<bool> was_int_; // нужен, чтобы вернуть целые при откате в Array
+    Array values_;
+    
+    void promote();
+    void unpack();
+};
+
+/**
+ * @brief Потоковый (push) парсер для документов, приходящих частями
+ *
+ * Состояние разбора (стек контейнеров, незавершённый токен) сохраняется
+ * между вызовами feed(), поэтому документ не нужно склеивать в один буфер.
+ */
+class MinJSON::StreamParser {
+public:
+    // Передаёт очередной фрагмент документа; ошибка запоминается до reset()
+    [[nodiscard]] std::optional<Error> feed(std::string_view chunk) noexcept;
+    
+    // Завершает разбор и возвращает документ; парсер готов к повторному использованию
+    [[nodiscard]] Result<Value> finish() noexcept;
+    
+    void reset() noexcept;
+    
+    [[nodiscard]] size_t depth() const noexcept {
+        return frames_.size();
+    }
+
+private:
+    enum class Mode { Structure, String, Number, Literal };
+    enum class State { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Done };
+    
+    struct Frame {
+        bool is_object = false;
+        ArrayBuilder array;
+        Object object;
+        std::string key;
+    };
+    
+    MinJSON lexer_;
+    std::vector<Frame> frames_;
+    std::string token_;
+    Value root_;
+    std::optional<Error> error_;
+    size_t offset_ = 0;      // смещение текущего байта от начала документа
+    size_t token_start_ = 0;
+    Mode mode_ = Mode::Structure;
+    State state_ = State::Value;
+    bool reading_key_ = false;
+    bool escape_ = false;
+    int unicode_left_ = 0;
+    
+    void consume_char(char c);
+    void consume_structural(char c);
+    void begin_value(char c);
+    void complete_token();
+    void emit_value(Value value);
+    void close_container();
+    void fail(Error error) noexcept;
+    void fail(Error::Code code) noexcept {
+        fail(Error{code, offset_});
+    }
+};
+
+// Ошибки
+inline std::string_view MinJSON::Error::message() const noexcept {
+    switch (code) {
+        case Code::UnexpectedCharacter: return "Unexpected character";
+        case Code::ExpectedNull: return "Expected 'null'";
+        case Code::ExpectedBoolean: return "Expected boolean value";
+        case Code::ExpectedQuote: return "Expected '\"'";
+        case Code::IncompleteUnicodeEscape: return "Incomplete Unicode escape";
+        case Code::UnterminatedString: return "Unterminated string";
+        case Code::InvalidNumber: return "Invalid number";
+        case Code::ExpectedArrayDelimiter: return "Expected ',' or ']' in array";
+        case Code::ExpectedColon: return "Expected ':' in object";
+        case Code::ExpectedObjectDelimiter: return "Expected ',' or '}' in object";
+        case Code::UnexpectedEndOfInput: return "Unexpected end of input";
+        case Code::TrailingCharacters: return "Unexpected character after document";
+        case Code::SchemaType: return "Schema violation: unexpected value type";
+        case Code::SchemaEnum: return "Schema violation: value is not in 'enum'";
+        case Code::SchemaMinimum: return "Schema violation: value is less than 'minimum'";
+        case Code::SchemaMaximum: return "Schema violation: value is greater than 'maximum'";
+        case Code::SchemaMinLength: return "Schema violation: string is shorter than 'minLength'";
+        case Code::SchemaMaxLength: return "Schema violation: string is longer than 'maxLength'";
+        case Code::SchemaMinItems: return "Schema violation: array is shorter than 'minItems'";
+        case Code::SchemaMaxItems: return "Schema violation: array is longer than 'maxItems'";
+        case Code::SchemaPattern: return "Schema violation: string does not match 'pattern'";
+        case Code::SchemaPatternInputTooLong: return "Schema violation: string is too long to match 'pattern'";
+        case Code::SchemaRequired: return "Schema violation: missing required property";
+        case Code::InvalidSchema: return "Invalid schema";
+        case Code::InvalidSchemaPattern: return "Invalid schema 'pattern'";
+        case Code::InvalidPath: return "Invalid path";
+        case Code::PathNotFound: return "Path not found";
+        case Code::ExpectedObject: return "Expected object";
+        case Code::ExpectedArray: return "Expected array";
+        case Code::IndexOutOfRange: return "Index out of range";
+        case Code::Internal: return "Internal error";
+    }
+    return "Unknown error";
+}
+
+inline MinJSON::Error::Location MinJSON::Error::location(std::string_view input) const noexcept {
+    const size_t end = std::min(offset, input.size());
+    Location result{1, 1};
+    for (size_t i = 0; i < end; ++i) {
+        if (input[i] == '\n') {
+            ++result.line;
+            result.column = 1;
+        } else {
+            ++result.column;
+        }
+    }
+    return result;
+}
+
 // Реализация методов парсинга
 inline void MinJSON::skip_whitespace() noexcept {
     while (pos_ < text_.size() && is_whitespace(text_[pos_])) {
@@ -184,6 +530,10 @@ inline bool MinJSON::is_digit(char c) noexcept {
     return c >= '0' && c <= '9';
 }
 
+inline bool MinJSON::is_number_char(char c) noexcept {
+    return is_digit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
 inline bool MinJSON::is_whitespace(char c) noexcept {
     return c == ' ' || c == '\t' || c == '\n' || c == '\r';
 }
@@ -194,24 +544,38 @@ inline std::string MinJSON::to_lower(std::string str) noexcept {
     return str;
 }
 
-inline MinJSON::Result<MinJSON::Value> MinJSON::parse_value() {
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse_value(const Schema* schema) {
     const char c = peek();
-    if (c == 'n') return parse_null();
-    if (c == 't' || c == 'f') return parse_bool();
-    if (c == '"') return parse_string();
-    if (c == '[') return parse_array();
-    if (c == '{') return parse_object();
-    if (is_digit(c) || c == '-' || c == '.') return parse_number();
+    const size_t start = pos_;
+    if (schema) {
+        // Тип значения известен по первому байту — отклоняем сразу
+        if (auto code = validate_start(*schema, c)) return make_error(*code);
+    }
+    if (c == '[') return parse_array(schema);
+    if (c == '{') return parse_object(schema);
     
-    return Error("Unexpected character: " + std::string(1, c));
+    Result<Value> result;
+    if (c == 'n') result = parse_null();
+    else if (c == 't' || c == 'f') result = parse_bool();
+    else if (c == '"') result = parse_string();
+    else if (is_digit(c) || c == '-' || c == '.') result = parse_number();
+    else if (pos_ >= text_.size()) return make_error(Error::Code::UnexpectedEndOfInput);
+    else return make_error(Error::Code::UnexpectedCharacter);
+    
+    if (schema) {
+        if (const auto* value = std::get_if<Value>(&result)) {
+            if (auto code = validate_scalar(*schema, *value)) return Error{*code, start};
+        }
+    }
+    return result;
 }
 
 inline MinJSON::Result<MinJSON::Value> MinJSON::parse_null() {
     if (text_.substr(pos_, 4) == "null") {
         pos_ += 4;
-        return nullptr;
+        return Value(nullptr);
     }
-    return Error("Expected 'null'");
+    return make_error(Error::Code::ExpectedNull);
 }
 
 inline MinJSON::Result<MinJSON::Value> MinJSON::parse_bool() {
@@ -223,13 +587,14 @@ inline MinJSON::Result<MinJSON::Value> MinJSON::parse_bool() {
         pos_ += 5;
         return false;
     }
-    return Error("Expected boolean value");
+    return make_error(Error::Code::ExpectedBoolean);
 }
 
 inline MinJSON::Result<MinJSON::Value> MinJSON::parse_string() {
-    if (consume() != '"') {
-        return Error("Expected '\"'");
+    if (peek() != '"') {
+        return make_error(Error::Code::ExpectedQuote);
     }
+    consume();
     
     std::string result;
     while (pos_ < text_.size() && peek() != '"') {
@@ -247,7 +612,7 @@ inline MinJSON::Result<MinJSON::Value> MinJSON::parse_string() {
                 case 't': result += '\t'; break;
                 case 'u': {
                     if (pos_ + 4 > text_.size()) {
-                        return Error("Incomplete Unicode escape");
+                        return make_error(Error::Code::IncompleteUnicodeEscape);
                     }
                     result += text_.substr(pos_, 4);
                     pos_ += 4;
@@ -261,9 +626,9 @@ inline MinJSON::Result<MinJSON::Value> MinJSON::parse_string() {
     }
     
     if (consume() != '"') {
-        return Error("Unterminated string");
+        return make_error(Error::Code::UnterminatedString);
     }
-    return result;
+    return Value(std::move(result));
 }
 
 inline MinJSON::Result<MinJSON::Value> MinJSON::parse_number() {
@@ -276,7 +641,7 @@ inline MinJSON::Result<MinJSON::Value> MinJSON::parse_number() {
         char c = peek();
         if (is_digit(c)) {
             consume();
-        } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        } else if (is_number_char(c)) {
             is_float = true;
             consume();
         } else {
@@ -284,186 +649,1249 @@ inline MinJSON::Result<MinJSON::Value> MinJSON::parse_number() {
         }
     }
     
-    std::string num_str(text_.substr(start, pos_ - start));
+    const char* first = text_.data() + start;
+    const char* last = text_.data() + pos_;
+    if (is_float) {
+        double value = 0.0;
+        if (auto [ptr, ec] = std::from_chars(first, last, value); ec == std::errc() && ptr == last) {
+            return value;
+        }
+    } else {
+        int value = 0;
+        if (auto [ptr, ec] = std::from_chars(first, last, value); ec == std::errc() && ptr == last) {
+            return value;
+        }
+    }
+    return Error{Error::Code::InvalidNumber, start};
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse_array(const Schema* schema) {
+    const size_t start = pos_;
+    consume(); // '['
+    skip_whitespace();
+    
+    const Schema* items = schema ? schema->items.get() : nullptr;
+    ArrayBuilder result;
+    if (peek() == ']') {
+        consume();
+    } else {
+        while (true) {
+            const size_t item_start = pos_;
+            auto value = parse_value(items);
+            if (auto* err = std::get_if<Error>(&value)) {
+                return *err;
+            }
+            result.push(std::get<Value>(std::move(value)));
+            if (schema && schema->max_items && result.size() > *schema->max_items) {
+                return Error{Error::Code::SchemaMaxItems, item_start};
+            }
+            skip_whitespace();
+            
+            if (peek() == ',') {
+                consume();
+                skip_whitespace();
+            } else if (peek() == ']') {
+                consume();
+                break;
+            } else {
+                return make_error(Error::Code::ExpectedArrayDelimiter);
+            }
+        }
+    }
+    
+    if (schema && schema->min_items && result.size() < *schema->min_items) {
+        return Error{Error::Code::SchemaMinItems, start};
+    }
+    return result.finish();
+}
+
+inline void MinJSON::ArrayBuilder::push(Value value) {
+    ++size_;
+    const auto* i = std::any_cast<int>(&value);
+    const auto* d = std::any_cast<double>(&value);
+    
+    switch (kind_) {
+        case Kind::Empty:
+            if (i) {
+                kind_ = Kind::Ints;
+                ints_.push_back(*i);
+                return;
+            }
+            if (d) {
+                kind_ = Kind::Doubles;
+                doubles_.push_back(*d);
+                was_int_.push_back(false);
+                return;
+            }
+            kind_ = Kind::Generic;
+            break;
+        case Kind::Ints:
+            if (i) {
+                ints_.push_back(*i);
+                return;
+            }
+            if (d) {
+                promote();
+                doubles_.push_back(*d);
+                was_int_.push_back(false);
+                return;
+            }
+            unpack();
+            break;
+        case Kind::Doubles:
+            if (i || d) {
+                doubles_.push_back(i ? *i : *d);
+                was_int_.push_back(i != nullptr);
+                return;
+            }
+            unpack();
+            break;
+        case Kind::Generic:
+            break;
+    }
+    values_.push_back(std::move(value));
+}
+
+inline void MinJSON::ArrayBuilder::append(ArrayBuilder&& other) {
+    if (other.kind_ == Kind::Empty) return;
+    if (kind_ == Kind::Empty) {
+        *this = std::move(other);
+        return;
+    }
+    
+    if (kind_ == Kind::Ints && other.kind_ == Kind::Ints) {
+        ints_.insert(ints_.end(), other.ints_.begin(), other.ints_.end());
+    } else if (kind_ != Kind::Generic && other.kind_ != Kind::Generic) {
+        promote();
+        other.promote();
+        doubles_.insert(doubles_.end(), other.doubles_.begin(), other.doubles_.end());
+        was_int_.insert(was_int_.end(), other.was_int_.begin(), other.was_int_.end());
+    } else {
+        size_ += other.size_;
+        unpack();
+        other.unpack();
+        values_.insert(values_.end(), std::make_move_iterator(other.values_.begin()), std::make_move_iterator(other.values_.end()));
+        return;
+    }
+    size_ += other.size_;
+}
+
+inline MinJSON::Value MinJSON::ArrayBuilder::finish() {
+    switch (kind_) {
+        case Kind::Ints: return std::move(ints_);
+        case Kind::Doubles: return std::move(doubles_);
+        default: return std::move(values_);
+    }
+}
+
+inline void MinJSON::ArrayBuilder::promote() {
+    if (kind_ != Kind::Ints) return;
+    doubles_.assign(ints_.begin(), ints_.end());
+    was_int_.assign(ints_.size(), true);
+    IntArray().swap(ints_);
+    kind_ = Kind::Doubles;
+}
+
+inline void MinJSON::ArrayBuilder::unpack() {
+    values_.reserve(size_);
+    if (kind_ == Kind::Ints) {
+        for (int x : ints_) values_.emplace_back(x);
+        IntArray().swap(ints_);
+    } else if (kind_ == Kind::Doubles) {
+        for (size_t k = 0; k < doubles_.size(); ++k) {
+            if (was_int_[k]) values_.emplace_back(static_cast<int>(doubles_[k]));
+            else values_.emplace_back(doubles_[k]);
+        }
+        DoubleArray().swap(doubles_);
+        std::vector<bool>().swap(was_int_);
+    }
+    kind_ = Kind::Generic;
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse_object(const Schema* schema) {
+    const size_t start = pos_;
+    consume(); // '{'
+    skip_whitespace();
+    
+    Object result;
+    if (peek() == '}') {
+        consume();
+    } else {
+        while (true) {
+            if (auto err = parse_member(result, schema)) {
+                return *err;
+            }
+            skip_whitespace();
+            
+            if (peek() == ',') {
+                consume();
+                skip_whitespace();
+            } else if (peek() == '}') {
+                consume();
+                break;
+            } else {
+                return make_error(Error::Code::ExpectedObjectDelimiter);
+            }
+        }
+    }
+    
+    if (schema) {
+        for (const auto& name : schema->required) {
+            if (!result.contains(name)) {
+                return Error{Error::Code::SchemaRequired, start};
+            }
+        }
+    }
+    return result;
+}
+
+inline std::optional<MinJSON::Error> MinJSON::parse_member(Object& result, const Schema* schema) {
+    auto key = parse_string();
+    if (auto* err = std::get_if<Error>(&key)) {
+        return *err;
+    }
+    skip_whitespace();
+    
+    if (peek() != ':') {
+        return make_error(Error::Code::ExpectedColon);
+    }
+    consume();
+    skip_whitespace();
+    
+    auto name = std::move(*std::any_cast<std::string>(&std::get<Value>(key)));
+    const Schema* property = nullptr;
+    if (schema) {
+        if (auto it = schema->properties.find(name); it != schema->properties.end()) {
+            property = it->second.get();
+        }
+    }
+    
+    auto value = parse_value(property);
+    if (auto* err = std::get_if<Error>(&value)) {
+        return *err;
+    }
+    
+    result[std::move(name)] = std::get<Value>(std::move(value));
+    return std::nullopt;
+}
+
+// Сериализация
+inline std::string MinJSON::quote_string(std::string_view str) const noexcept {
+    std::ostringstream oss;
+    oss << '"';
+    for (char c : str) {
+        switch (c) {
+            case '"': oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\b': oss << "\\b"; break;
+            case '\f': oss << "\\f"; break;
+            case '\n': oss << "\\n"; break;
+            case '\r': oss << "\\r"; break;
+            case '\t': oss << "\\t"; break;
+            default: 
+                if (c < 0x20) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                } else {
+                    oss << c;
+                }
+        }
+    }
+    oss << '"';
+    return oss.str();
+}
+
+inline std::string MinJSON::stringify_array(const Array& arr, bool pretty) const noexcept {
+    std::string result = "[";
+    for (size_t i = 0; i < arr.size(); ++i) {
+        if (i > 0) result += ",";
+        result += stringify(arr[i], pretty);
+    }
+    return result + "]";
+}
+
+template <typename T>
+std::string MinJSON::stringify_packed(const std::vector<T>& arr) const noexcept {
+    // Формат совпадает с stringify() для отдельных чисел (std::to_string)
+    std::string result = "[";
+    result.reserve(arr.size() * (std::same_as<T, int> ? 8 : 12) + 2);
+    char buffer[512];
+    for (size_t i = 0; i < arr.size(); ++i) {
+        if (i > 0) result += ',';
+        std::to_chars_result res;
+        if constexpr (std::same_as<T, double>) {
+            res = std::to_chars(buffer, buffer + sizeof(buffer), arr[i], std::chars_format::fixed, 6);
+        } else {
+            res = std::to_chars(buffer, buffer + sizeof(buffer), arr[i]);
+        }
+        result.append(buffer, res.ptr);
+    }
+    return result + "]";
+}
+
+inline std::string MinJSON::stringify_object(const Object& obj, bool pretty) const noexcept {
+    std::string result = "{";
+    bool first = true;
+    for (const auto& [key, value] : obj) {
+        if (!first) result += ",";
+        result += quote_string(key) + ":" + stringify(value, pretty);
+        first = false;
+    }
+    return result + "}";
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse(std::string_view input) noexcept {
+    try {
+        text_ = input;
+        pos_ = 0;
+        skip_whitespace();
+        return finish_document(parse_value());
+    } catch (...) {
+        return make_error(Error::Code::Internal);
+    }
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::finish_document(Result<Value> result) noexcept {
+    // После документа допускаются только пробельные символы
+    if (std::holds_alternative<Value>(result)) {
+        skip_whitespace();
+        if (pos_ < text_.size()) {
+            return make_error(Error::Code::TrailingCharacters);
+        }
+    }
+    return result;
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse(std::string_view input, const Schema& schema) noexcept {
+    try {
+        text_ = input;
+        pos_ = 0;
+        skip_whitespace();
+        return finish_document(parse_value(&schema));
+    } catch (...) {
+        return make_error(Error::Code::Internal);
+    }
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse_parallel(std::string_view input, size_t threads) noexcept {
+    try {
+        text_ = input;
+        pos_ = 0;
+        skip_whitespace();
+        
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::min(threads, input.size() / parallel_min_range_);
+        
+        const char open = peek();
+        if (threads < 2 || (open != '[' && open != '{')) {
+            return finish_document(parse_value());
+        }
+        
+        const bool is_object = (open == '{');
+        const size_t begin = pos_ + 1;
+        
+        // Диапазон i — элементы между (i - 1)-й и i-й точками разреза (запятыми)
+        struct Part {
+            std::optional<Error> error;
+            Object object;
+            ArrayBuilder array;
+        };
+        std::vector<Part> parts(threads);
+        auto run = [&](size_t i, size_t from, size_t to, bool is_last) noexcept {
+            auto& part = parts[i];
+            try {
+                MinJSON worker;
+                part.error = worker.parse_range(input, from, to, is_last,
+                    is_object ? &part.object : nullptr, is_object ? nullptr : &part.array);
+            } catch (...) {
+                part.error = Error{Error::Code::Internal, from};
+            }
+        };
+        
+        // Поток запускается, как только найден конец его диапазона, поэтому
+        // поиск следующих точек разреза идёт параллельно с разбором
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        size_t ranges = 0;
+        size_t from = begin;
+        find_split_points(input, begin, threads, [&](size_t comma) {
+            const size_t i = ranges++;
+            try {
+                pool.emplace_back(run, i, from, comma, false);
+            } catch (...) {
+                run(i, from, comma, false); // поток не запустился — разбираем диапазон сами
+            }
+            from = comma + 1;
+        });
+        if (ranges == 0) {
+            return finish_document(parse_value());
+        }
+        
+        run(ranges, from, input.size(), true);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        parts.resize(ranges + 1);
+        
+        // Сообщаем первую ошибку в порядке документа
+        for (const auto& part : parts) {
+            if (part.error) return *part.error;
+        }
+        
+        if (is_object) {
+            auto result = std::move(parts[0].object);
+            for (size_t i = 1; i < parts.size(); ++i) {
+                for (auto& [key, value] : parts[i].object) {
+                    result.insert_or_assign(key, std::move(value));
+                }
+            }
+            return result;
+        }
+        
+        // Построители склеиваются с тем же результатом, что и при последовательном разборе
+        ArrayBuilder result = std::move(parts[0].array);
+        for (size_t i = 1; i < parts.size(); ++i) {
+            result.append(std::move(parts[i].array));
+        }
+        return result.finish();
+    } catch (...) {
+        return make_error(Error::Code::Internal);
+    }
+}
+
+template <typename OnSplit>
+void MinJSON::find_split_points(std::string_view input, size_t begin, size_t parts, OnSplit&& on_split) {
+    // Запятые верхнего уровня контейнера, ближайшие к равным долям входа.
+    // Строки пропускаются поиском закрывающей кавычки, как в skip_string(),
+    // поэтому запятая внутри строки или вложенного значения не станет точкой разреза.
+    const size_t step = (input.size() - begin) / parts;
+    size_t target = begin + step;
+    size_t depth = 0;
+    size_t found = 0;
+    
+    for (size_t i = begin; i < input.size() && found + 1 < parts; ++i) {
+        switch (input[i]) {
+            case '"': {
+                size_t quote = i;
+                while (true) {
+                    quote = input.find('"', quote + 1);
+                    if (quote == std::string_view::npos) return; // ошибку сообщит разбор
+                    
+                    // Открывающая кавычка в позиции i ограничивает подсчёт слэшей
+                    size_t backslashes = 0;
+                    while (input[quote - backslashes - 1] == '\\') ++backslashes;
+                    if (backslashes % 2 == 0) break;
+                }
+                i = quote;
+                break;
+            }
+            case '[':
+            case '{':
+                ++depth;
+                break;
+            case ']':
+            case '}':
+                if (depth == 0) return; // конец контейнера верхнего уровня
+                --depth;
+                break;
+            case ',':
+                if (depth == 0 && i >= target) {
+                    on_split(i);
+                    ++found;
+                    target = i + step;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+inline std::optional<MinJSON::Error> MinJSON::parse_range(
+    std::string_view input,
+    size_t from,
+    size_t to,
+    bool is_last,
+    Object* object,
+    ArrayBuilder* array
+) {
+    // Вход обрезается по границе диапазона, а смещения в ошибках остаются абсолютными
+    text_ = input.substr(0, to);
+    pos_ = from;
+    skip_whitespace();
+    
+    // Элементы пишутся либо в object, либо в array — второй указатель нулевой
+    const bool is_object = (object != nullptr);
+    while (true) {
+        if (is_object) {
+            if (auto err = parse_member(*object, nullptr)) return err;
+        } else {
+            auto value = parse_value();
+            if (auto* err = std::get_if<Error>(&value)) return *err;
+            array->push(std::get<Value>(std::move(value)));
+        }
+        skip_whitespace();
+        
+        if (!is_last && pos_ == to) {
+            break;
+        }
+        if (peek() == ',') {
+            consume();
+            skip_whitespace();
+        } else if (is_last && peek() == (is_object ? '}' : ']')) {
+            consume();
+            break;
+        } else if (is_object) {
+            return make_error(Error::Code::ExpectedObjectDelimiter);
+        } else {
+            return make_error(Error::Code::ExpectedArrayDelimiter);
+        }
+    }
+    
+    if (is_last) {
+        skip_whitespace();
+        if (pos_ < text_.size()) return make_error(Error::Code::TrailingCharacters);
+    }
+    return std::nullopt;
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse(std::string_view input, const Projection& projection) noexcept {
+    try {
+        text_ = input;
+        pos_ = 0;
+        skip_whitespace();
+        
+        // Корень не того вида, что ожидает проекция, даёт пустой контейнер ожидаемого вида
+        auto result = parse_projected(projection);
+        if (auto* value = std::get_if<Value>(&result); value && !value->has_value()) {
+            *value = projection.keys.empty() ? Value(Array{}) : Value(Object{});
+        }
+        return finish_document(std::move(result));
+    } catch (...) {
+        return make_error(Error::Code::Internal);
+    }
+}
+
+inline std::string MinJSON::stringify(const Value& value, bool pretty) const noexcept {
+    try {
+        if (!value.has_value()) return "null";
+        if (const auto* p = std::any_cast<bool>(&value)) return *p ? "true" : "false";
+        if (const auto* p = std::any_cast<int>(&value)) return std::to_string(*p);
+        if (const auto* p = std::any_cast<double>(&value)) return std::to_string(*p);
+        if (const auto* p = std::any_cast<std::string>(&value)) return quote_string(*p);
+        if (const auto* p = std::any_cast<Array>(&value)) return stringify_array(*p, pretty);
+        if (const auto* p = std::any_cast<IntArray>(&value)) return stringify_packed(*p);
+        if (const auto* p = std::any_cast<DoubleArray>(&value)) return stringify_packed(*p);
+        if (const auto* p = std::any_cast<Object>(&value)) return stringify_object(*p, pretty);
+        
+        if (auto reflected = reflect_to_json(value); reflected) {
+            return stringify(*reflected, pretty);
+        }
+        
+        return "\"<unsupported type>\"";
+    } catch (...) {
+        return "\"<stringify error>\"";
+    }
+}
+
+// Схемы
+inline MinJSON::Result<MinJSON::Schema> MinJSON::compile_schema(
+    const Value& schema,
+    size_t pattern_max_input,
+    bool skip_long_pattern_input
+) const noexcept {
+    try {
+        Schema result;
+        result.pattern_max_input = pattern_max_input;
+        result.skip_long_pattern_input = skip_long_pattern_input;
+        if (auto err = compile_schema_node(schema, result)) return *err;
+        return result;
+    } catch (...) {
+        return Error{Error::Code::Internal, 0};
+    }
+}
+
+inline std::optional<MinJSON::Error> MinJSON::compile_schema_node(const Value& schema, Schema& result) const {
+    // Смещение в ошибках схемы не определено — документ ещё не разбирается
+    const Error invalid{Error::Code::InvalidSchema, 0};
+    
+    const auto* obj = std::any_cast<Object>(&schema);
+    if (!obj) return invalid;
+    
+    auto as_number = [](const Value& v) -> std::optional<double> {
+        if (const auto* p = std::any_cast<int>(&v)) return *p;
+        if (const auto* p = std::any_cast<double>(&v)) return *p;
+        return std::nullopt;
+    };
+    auto as_size = [](const Value& v) -> std::optional<size_t> {
+        if (const auto* p = std::any_cast<int>(&v); p && *p >= 0) return static_cast<size_t>(*p);
+        return std::nullopt;
+    };
+    // Вложенные схемы наследуют ограничение для pattern
+    auto make_child = [&result] {
+        auto child = std::make_shared<Schema>();
+        child->pattern_max_input = result.pattern_max_input;
+        child->skip_long_pattern_input = result.skip_long_pattern_input;
+        return child;
+    };
+    auto as_type = [](const Value& v) -> unsigned {
+        const auto* name = std::any_cast<std::string>(&v);
+        if (!name) return 0;
+        if (*name == "null") return Schema::NullType;
+        if (*name == "boolean") return Schema::BooleanType;
+        if (*name == "integer") return Schema::IntegerType;
+        if (*name == "number") return Schema::NumberType | Schema::IntegerType;
+        if (*name == "string") return Schema::StringType;
+        if (*name == "array") return Schema::ArrayType;
+        if (*name == "object") return Schema::ObjectType;
+        return 0;
+    };
+    
+    for (const auto& [keyword, value] : *obj) {
+        if (keyword == "type") {
+            auto list = unpack_array(value);
+            if (!list) list = Array{value};
+            for (const auto& item : *list) {
+                const unsigned type = as_type(item);
+                if (type == 0) return invalid;
+                result.types |= type;
+            }
+        } else if (keyword == "properties") {
+            const auto* props = std::any_cast<Object>(&value);
+            if (!props) return invalid;
+            for (const auto& [name, sub] : *props) {
+                auto property = make_child();
+                if (auto err = compile_schema_node(sub, *property)) return err;
+                result.properties[name] = std::move(property);
+            }
+        } else if (keyword == "required") {
+            auto list = unpack_array(value);
+            if (!list) return invalid;
+            for (const auto& item : *list) {
+                const auto* name = std::any_cast<std::string>(&item);
+                if (!name) return invalid;
+                result.required.push_back(*name);
+            }
+        } else if (keyword == "items") {
+            result.items = make_child();
+            if (auto err = compile_schema_node(value, *result.items)) return err;
+        } else if (keyword == "enum") {
+            auto list = unpack_array(value);
+            if (!list) return invalid;
+            for (const auto& item : *list) {
+                if (item.type() != typeid(int) && item.type() != typeid(double) &&
+                    item.type() != typeid(bool) && item.type() != typeid(std::string) &&
+                    item.type() != typeid(std::nullptr_t)) {
+                    return invalid; // поддерживаются только скалярные значения
+                }
+            }
+            result.enum_values = std::move(*list);
+        } else if (keyword == "minimum" || keyword == "maximum") {
+            auto number = as_number(value);
+            if (!number) return invalid;
+            (keyword == "minimum" ? result.minimum : result.maximum) = number;
+        } else if (keyword == "minLength" || keyword == "maxLength" ||
+                   keyword == "minItems" || keyword == "maxItems") {
+            auto size = as_size(value);
+            if (!size) return invalid;
+            if (keyword == "minLength") result.min_length = size;
+            else if (keyword == "maxLength") result.max_length = size;
+            else if (keyword == "minItems") result.min_items = size;
+            else result.max_items = size;
+        } else if (keyword == "pattern") {
+            const auto* re = std::any_cast<std::string>(&value);
+            if (!re) return invalid;
+            try {
+                result.pattern.emplace(*re, std::regex::ECMAScript);
+            } catch (const std::regex_error&) {
+                return Error{Error::Code::InvalidSchemaPattern, 0};
+            }
+        }
+        // Остальные ключевые слова игнорируются, как и требует JSON Schema
+    }
+    return std::nullopt;
+}
+
+inline std::optional<MinJSON::Error::Code> MinJSON::validate_start(const Schema& schema, char c) const noexcept {
+    unsigned type = 0;
+    if (c == 'n') type = Schema::NullType;
+    else if (c == 't' || c == 'f') type = Schema::BooleanType;
+    else if (c == '"') type = Schema::StringType;
+    else if (c == '[') type = Schema::ArrayType;
+    else if (c == '{') type = Schema::ObjectType;
+    else if (is_digit(c) || c == '-' || c == '.') type = Schema::IntegerType | Schema::NumberType;
+    else return std::nullopt; // ошибку синтаксиса сообщит parse_value()
+    
+    if (schema.types != 0 && (schema.types & type) == 0) {
+        return Error::Code::SchemaType;
+    }
+    if (!schema.enum_values.empty() && (c == '[' || c == '{')) {
+        return Error::Code::SchemaEnum;
+    }
+    return std::nullopt;
+}
+
+inline std::optional<MinJSON::Error::Code> MinJSON::validate_scalar(const Schema& schema, const Value& value) const noexcept {
+    std::optional<double> number;
+    if (const auto* p = std::any_cast<int>(&value)) number = *p;
+    if (const auto* p = std::any_cast<double>(&value)) {
+        number = *p;
+        // Дробное число не подходит под "integer"
+        if (schema.types != 0 && (schema.types & Schema::NumberType) == 0 && std::floor(*p) != *p) {
+            return Error::Code::SchemaType;
+        }
+    }
+    
+    if (number) {
+        if (schema.minimum && *number < *schema.minimum) {
+            return Error::Code::SchemaMinimum;
+        }
+        if (schema.maximum && *number > *schema.maximum) {
+            return Error::Code::SchemaMaximum;
+        }
+    }
+    
+    if (const auto* str = std::any_cast<std::string>(&value)) {
+        if (schema.min_length || schema.max_length) {
+            // Длина считается в кодовых точках UTF-8
+            size_t length = std::count_if(str->begin(), str->end(),
+                [](unsigned char c) { return (c & 0xC0) != 0x80; });
+            if (schema.min_length && length < *schema.min_length) {
+                return Error::Code::SchemaMinLength;
+            }
+            if (schema.max_length && length > *schema.max_length) {
+                return Error::Code::SchemaMaxLength;
+            }
+        }
+        if (schema.pattern && str->size() > schema.pattern_max_input) {
+            if (!schema.skip_long_pattern_input) {
+                return Error::Code::SchemaPatternInputTooLong;
+            }
+        } else if (schema.pattern) {
+            try {
+                if (!std::regex_search(*str, *schema.pattern)) {
+                    return Error::Code::SchemaPattern;
+                }
+            } catch (const std::regex_error&) {
+                // error_complexity / error_stack — считаем строку несоответствующей
+                return Error::Code::SchemaPattern;
+            }
+        }
+    }
+    
+    if (!schema.enum_values.empty()) {
+        auto matches = [&](const Value& candidate) { return scalar_equals(candidate, value); };
+        if (std::none_of(schema.enum_values.begin(), schema.enum_values.end(), matches)) {
+            return Error::Code::SchemaEnum;
+        }
+    }
+    return std::nullopt;
+}
+
+inline bool MinJSON::scalar_equals(const Value& lhs, const Value& rhs) noexcept {
+    auto number = [](const Value& v) -> std::optional<double> {
+        if (const auto* p = std::any_cast<int>(&v)) return *p;
+        if (const auto* p = std::any_cast<double>(&v)) return *p;
+        return std::nullopt;
+    };
+    
+    if (auto l = number(lhs), r = number(rhs); l || r) return l && r && *l == *r;
+    if (lhs.type() != rhs.type()) return false;
+    if (const auto* p = std::any_cast<bool>(&lhs)) return *p == *std::any_cast<bool>(&rhs);
+    if (const auto* p = std::any_cast<std::string>(&lhs)) return *p == *std::any_cast<std::string>(&rhs);
+    return lhs.type() == typeid(std::nullptr_t);
+}
+
+// Проекции
+inline MinJSON::Result<MinJSON::Projection> MinJSON::compile_projection(
+    const std::vector<std::string_view>& paths
+) const noexcept {
     try {
-        if (is_float) {
-            return std::stod(num_str);
+        Projection result;
+        for (auto path : paths) {
+            Projection* node = &result;
+            size_t start = 0;
+            
+            // Части пути между `[*]` разбираются обычным parse_path()
+            while (true) {
+                const size_t star = path.find("[*]", start);
+                const auto piece = path.substr(start, star == std::string_view::npos ? star : star - start);
+                
+                auto segments = parse_path(piece);
+                if (auto* err = std::get_if<Error>(&segments)) {
+                    return Error{err->code, start + err->offset};
+                }
+                for (const auto& segment : *std::get<0>(segments)) {
+                    std::shared_ptr<Projection>* child = nullptr;
+                    if (const auto* key = std::get_if<KeySegment>(&segment)) {
+                        child = &node->keys[key->value];
+                    } else {
+                        child = &node->indices[std::get<IndexSegment>(segment).value];
+                    }
+                    if (!*child) *child = std::make_shared<Projection>();
+                    node = child->get();
+                }
+                
+                if (star == std::string_view::npos) break;
+                if (!node->any_index) node->any_index = std::make_shared<Projection>();
+                node = node->any_index.get();
+                start = star + 3;
+            }
+            node->terminal = true;
         }
-        return std::stoi(num_str);
+        
+        expand_wildcards(result);
+        return result;
     } catch (...) {
-        return Error("Invalid number: " + num_str);
+        return Error{Error::Code::Internal, 0};
     }
 }
 
-inline MinJSON::Result<MinJSON::Value> MinJSON::parse_array() {
-    consume(); // '['
-    skip_whitespace();
+inline void MinJSON::merge_projection(Projection& target, const Projection& source) {
+    target.terminal = target.terminal || source.terminal;
+    auto merge_child = [](std::shared_ptr<Projection>& child, const Projection& from) {
+        if (!child) child = std::make_shared<Projection>();
+        merge_projection(*child, from);
+    };
+    for (const auto& [key, child] : source.keys) merge_child(target.keys[key], *child);
+    for (const auto& [index, child] : source.indices) merge_child(target.indices[index], *child);
+    if (source.any_index) merge_child(target.any_index, *source.any_index);
+}
+
+inline void MinJSON::expand_wildcards(Projection& projection) {
+    // Явный индекс должен видеть и пути из `[*]`, чтобы при разборе
+    // элементу массива соответствовал ровно один узел
+    if (projection.any_index) {
+        for (auto& [index, child] : projection.indices) {
+            merge_projection(*child, *projection.any_index);
+        }
+        expand_wildcards(*projection.any_index);
+    }
+    for (auto& [key, child] : projection.keys) expand_wildcards(*child);
+    for (auto& [index, child] : projection.indices) expand_wildcards(*child);
+}
+
+inline MinJSON::Result<MinJSON::Value> MinJSON::parse_projected(const Projection& projection) {
+    if (projection.terminal) {
+        return parse_value();
+    }
     
-    Array result;
-    if (peek() == ']') {
+    const char c = peek();
+    if (c == '{' && !projection.keys.empty()) {
         consume();
-        return result;
+        skip_whitespace();
+        
+        Object result;
+        if (peek() == '}') {
+            consume();
+            return result;
+        }
+        while (true) {
+            if (peek() != '"') {
+                return make_error(Error::Code::ExpectedQuote);
+            }
+            
+            // Ключ сравнивается без копирования, если в нём нет экранирования
+            const size_t key_start = pos_;
+            if (auto err = skip_string()) return *err;
+            std::string_view key = text_.substr(key_start + 1, pos_ - key_start - 2);
+            Value decoded;
+            if (key.find('\\') != std::string_view::npos) {
+                pos_ = key_start;
+                auto unescaped = parse_string();
+                if (auto* err = std::get_if<Error>(&unescaped)) return *err;
+                decoded = std::get<Value>(std::move(unescaped));
+                key = *std::any_cast<std::string>(&decoded);
+            }
+            skip_whitespace();
+            
+            if (peek() != ':') {
+                return make_error(Error::Code::ExpectedColon);
+            }
+            consume();
+            skip_whitespace();
+            
+            if (auto it = projection.keys.find(key); it != projection.keys.end()) {
+                auto value = parse_projected(*it->second);
+                if (auto* err = std::get_if<Error>(&value)) return *err;
+                if (std::get<Value>(value).has_value()) {
+                    result.insert_or_assign(std::string(key), std::get<Value>(std::move(value)));
+                }
+            } else if (auto err = skip_value()) {
+                return *err;
+            }
+            skip_whitespace();
+            
+            if (peek() == ',') {
+                consume();
+                skip_whitespace();
+            } else if (peek() == '}') {
+                consume();
+                return result;
+            } else {
+                return make_error(Error::Code::ExpectedObjectDelimiter);
+            }
+        }
     }
     
-    while (true) {
-        auto value = parse_value();
-        if (auto* err = std::get_if<Error>(&value)) {
-            return *err;
-        }
-        result.push_back(std::get<Value>(std::move(value)));
+    if (c == '[' && (!projection.indices.empty() || projection.any_index)) {
+        consume();
         skip_whitespace();
         
-        if (peek() == ',') {
+        ArrayBuilder result;
+        if (peek() == ']') {
             consume();
+            return result.finish();
+        }
+        for (size_t index = 0; ; ++index) {
+            const Projection* child = projection.any_index.get();
+            if (auto it = projection.indices.find(index); it != projection.indices.end()) {
+                child = it->second.get();
+            }
+            
+            if (child) {
+                auto value = parse_projected(*child);
+                if (auto* err = std::get_if<Error>(&value)) return *err;
+                // Пропущенные и не подошедшие к пути элементы заменяются на null, чтобы индексы не сдвигались
+                while (result.size() < index) result.push(Value(nullptr));
+                auto& item = std::get<Value>(value);
+                result.push(item.has_value() ? std::move(item) : Value(nullptr));
+            } else if (auto err = skip_value()) {
+                return *err;
+            }
             skip_whitespace();
-        } else if (peek() == ']') {
-            consume();
-            break;
-        } else {
-            return Error("Expected ',' or ']' in array");
+            
+            if (peek() == ',') {
+                consume();
+                skip_whitespace();
+            } else if (peek() == ']') {
+                consume();
+                return result.finish();
+            } else {
+                return make_error(Error::Code::ExpectedArrayDelimiter);
+            }
         }
     }
-    return result;
+    
+    // Скаляр или контейнер другого вида там, где путь ожидает контейнер, в проекцию не входит
+    if (auto err = skip_value()) return *err;
+    return Value{};
 }
 
-inline MinJSON::Result<MinJSON::Value> MinJSON::parse_object() {
-    consume(); // '{'
-    skip_whitespace();
+inline std::optional<MinJSON::Error> MinJSON::skip_value() noexcept {
+    const char c = peek();
+    if (c == '"') return skip_string();
     
-    Object result;
-    if (peek() == '}') {
-        consume();
-        return result;
+    if (c == '[' || c == '{') {
+        // Пропускаемое поддерево проверяется только на парность скобок.
+        // Виды открытых скобок хранятся в битах фиксированного размера.
+        const size_t start = pos_;
+        std::bitset<skip_max_depth_> is_object;
+        size_t depth = 0;
+        while (pos_ < text_.size()) {
+            const char ch = text_[pos_];
+            if (ch == '"') {
+                if (auto err = skip_string()) return err;
+                continue;
+            }
+            if (ch == '[' || ch == '{') {
+                if (depth == skip_max_depth_) {
+                    // Слишком глубокое поддерево разбирается полностью
+                    pos_ = start;
+                    try {
+                        auto value = parse_value();
+                        if (const auto* err = std::get_if<Error>(&value)) return *err;
+                        return std::nullopt;
+                    } catch (...) {
+                        return make_error(Error::Code::Internal);
+                    }
+                }
+                is_object[depth++] = (ch == '{');
+            } else if (ch == ']' || ch == '}') {
+                if (is_object[depth - 1] != (ch == '}')) {
+                    return make_error(is_object[depth - 1]
+                        ? Error::Code::ExpectedObjectDelimiter
+                        : Error::Code::ExpectedArrayDelimiter);
+                }
+                if (--depth == 0) {
+                    ++pos_;
+                    return std::nullopt;
+                }
+            }
+            ++pos_;
+        }
+        return make_error(Error::Code::UnexpectedEndOfInput);
     }
     
+    Result<Value> scalar;
+    if (c == 'n') scalar = parse_null();
+    else if (c == 't' || c == 'f') scalar = parse_bool();
+    else if (is_digit(c) || c == '-' || c == '.') scalar = parse_number();
+    else if (pos_ >= text_.size()) return make_error(Error::Code::UnexpectedEndOfInput);
+    else return make_error(Error::Code::UnexpectedCharacter);
+    
+    if (const auto* err = std::get_if<Error>(&scalar)) return *err;
+    return std::nullopt;
+}
+
+inline std::optional<MinJSON::Error> MinJSON::skip_string() noexcept {
+    const size_t start = pos_++; // '"'
     while (true) {
-        auto key = parse_string();
-        if (auto* err = std::get_if<Error>(&key)) {
-            return *err;
-        }
-        skip_whitespace();
-        
-        if (consume() != ':') {
-            return Error("Expected ':' in object");
+        const size_t quote = text_.find('"', pos_);
+        if (quote == std::string_view::npos) {
+            pos_ = text_.size();
+            return make_error(Error::Code::UnterminatedString);
         }
-        skip_whitespace();
         
-        auto value = parse_value();
-        if (auto* err = std::get_if<Error>(&value)) {
-            return *err;
+        // Кавычка экранирована, если перед ней нечётное число обратных слэшей
+        size_t backslashes = 0;
+        while (quote - backslashes > start + 1 && text_[quote - backslashes - 1] == '\\') {
+            ++backslashes;
         }
-        
-        result[std::any_cast<std::string>(std::get<Value>(key))] = 
-            std::get<Value>(std::move(value));
-        skip_whitespace();
-        
-        if (peek() == ',') {
-            consume();
-            skip_whitespace();
-        } else if (peek() == '}') {
-            consume();
-            break;
-        } else {
-            return Error("Expected ',' or '}' in object");
+        pos_ = quote + 1;
+        if (backslashes % 2 == 0) return std::nullopt;
+    }
+}
+
+// Потоковый парсинг
+inline std::optional<MinJSON::Error> MinJSON::StreamParser::feed(std::string_view chunk) noexcept {
+    try {
+        for (size_t i = 0; i < chunk.size() && !error_; ++i, ++offset_) {
+            consume_char(chunk[i]);
         }
+    } catch (...) {
+        fail(Error::Code::Internal);
     }
-    return result;
+    return error_;
 }
 
-// Сериализация
-inline std::string MinJSON::quote_string(std::string_view str) const noexcept {
-    std::ostringstream oss;
-    oss << '"';
-    for (char c : str) {
-        switch (c) {
-            case '"': oss << "\\\""; break;
-            case '\\': oss << "\\\\"; break;
-            case '\b': oss << "\\b"; break;
-            case '\f': oss << "\\f"; break;
-            case '\n': oss << "\\n"; break;
-            case '\r': oss << "\\r"; break;
-            case '\t': oss << "\\t"; break;
-            default: 
-                if (c < 0x20) {
-                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
-                } else {
-                    oss << c;
-                }
+inline MinJSON::Result<MinJSON::Value> MinJSON::StreamParser::finish() noexcept {
+    try {
+        if (!error_) {
+            if (mode_ == Mode::String) {
+                fail(Error::Code::UnterminatedString);
+            } else if (mode_ != Mode::Structure) {
+                complete_token();
+            }
+        }
+        if (!error_ && state_ != State::Done) {
+            fail(Error::Code::UnexpectedEndOfInput);
         }
+    } catch (...) {
+        fail(Error::Code::Internal);
     }
-    oss << '"';
-    return oss.str();
+    
+    Result<Value> result = error_ ? Result<Value>(*error_) : Result<Value>(std::move(root_));
+    reset();
+    return result;
 }
 
-inline std::string MinJSON::stringify_array(const Array& arr, bool pretty) const noexcept {
-    std::string result = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        if (i > 0) result += ",";
-        result += stringify(arr[i], pretty);
+inline void MinJSON::StreamParser::reset() noexcept {
+    frames_.clear();
+    token_.clear();
+    root_.reset();
+    error_.reset();
+    offset_ = 0;
+    token_start_ = 0;
+    mode_ = Mode::Structure;
+    state_ = State::Value;
+    reading_key_ = false;
+    escape_ = false;
+    unicode_left_ = 0;
+}
+
+inline void MinJSON::StreamParser::consume_char(char c) {
+    switch (mode_) {
+        case Mode::String:
+            token_ += c;
+            if (unicode_left_ > 0) {
+                --unicode_left_;
+            } else if (escape_) {
+                escape_ = false;
+                if (c == 'u') unicode_left_ = 4;
+            } else if (c == '\\') {
+                escape_ = true;
+            } else if (c == '"') {
+                complete_token();
+            }
+            return;
+        case Mode::Number:
+            if (is_number_char(c)) {
+                token_ += c;
+                return;
+            }
+            complete_token();
+            break;
+        case Mode::Literal:
+            if (c >= 'a' && c <= 'z') {
+                token_ += c;
+                return;
+            }
+            complete_token();
+            break;
+        case Mode::Structure:
+            break;
+    }
+    
+    if (!error_) {
+        consume_structural(c);
     }
-    return result + "]";
 }
 
-inline std::string MinJSON::stringify_object(const Object& obj, bool pretty) const noexcept {
-    std::string result = "{";
-    bool first = true;
-    for (const auto& [key, value] : obj) {
-        if (!first) result += ",";
-        result += quote_string(key) + ":" + stringify(value, pretty);
-        first = false;
+inline void MinJSON::StreamParser::consume_structural(char c) {
+    if (is_whitespace(c)) return;
+    
+    switch (state_) {
+        case State::ValueOrEnd:
+            if (c == ']') {
+                close_container();
+                return;
+            }
+            [[fallthrough]];
+        case State::Value:
+            begin_value(c);
+            return;
+        case State::KeyOrEnd:
+            if (c == '}') {
+                close_container();
+                return;
+            }
+            [[fallthrough]];
+        case State::Key:
+            if (c != '"') {
+                fail(Error::Code::ExpectedQuote);
+                return;
+            }
+            reading_key_ = true;
+            mode_ = Mode::String;
+            token_start_ = offset_;
+            token_.assign(1, c);
+            return;
+        case State::Colon:
+            if (c != ':') {
+                fail(Error::Code::ExpectedColon);
+                return;
+            }
+            state_ = State::Value;
+            return;
+        case State::CommaOrEnd:
+            if (frames_.back().is_object) {
+                if (c == ',') state_ = State::Key;
+                else if (c == '}') close_container();
+                else fail(Error::Code::ExpectedObjectDelimiter);
+            } else {
+                if (c == ',') state_ = State::Value;
+                else if (c == ']') close_container();
+                else fail(Error::Code::ExpectedArrayDelimiter);
+            }
+            return;
+        case State::Done:
+            fail(Error::Code::TrailingCharacters);
+            return;
     }
-    return result + "}";
 }
 
-inline MinJSON::Result<MinJSON::Value> MinJSON::parse(std::string_view input) noexcept {
-    try {
-        text_ = input;
-        pos_ = 0;
-        skip_whitespace();
-        return parse_value();
-    } catch (const std::exception& e) {
-        return Error(e.what());
+inline void MinJSON::StreamParser::begin_value(char c) {
+    if (c == '[' || c == '{') {
+        Frame frame;
+        frame.is_object = (c == '{');
+        frames_.push_back(std::move(frame));
+        state_ = (c == '{') ? State::KeyOrEnd : State::ValueOrEnd;
+        return;
+    }
+    
+    if (c == '"') {
+        reading_key_ = false;
+        mode_ = Mode::String;
+    } else if (c == 'n' || c == 't' || c == 'f') {
+        mode_ = Mode::Literal;
+    } else if (is_digit(c) || c == '-' || c == '.') {
+        mode_ = Mode::Number;
+    } else {
+        fail(Error::Code::UnexpectedCharacter);
+        return;
     }
+    token_start_ = offset_;
+    token_.assign(1, c);
 }
 
-inline std::string MinJSON::stringify(const Value& value, bool pretty) const noexcept {
-    try {
-        if (!value.has_value()) return "null";
-        if (const auto* p = std::any_cast<bool>(&value)) return *p ? "true" : "false";
-        if (const auto* p = std::any_cast<int>(&value)) return std::to_string(*p);
-        if (const auto* p = std::any_cast<double>(&value)) return std::to_string(*p);
-        if (const auto* p = std::any_cast<std::string>(&value)) return quote_string(*p);
-        if (const auto* p = std::any_cast<Array>(&value)) return stringify_array(*p, pretty);
-        if (const auto* p = std::any_cast<Object>(&value)) return stringify_object(*p, pretty);
-        
-        if (auto reflected = reflect_to_json(value); reflected) {
-            return stringify(*reflected, pretty);
-        }
-        
-        return "\"<unsupported type>\"";
-    } catch (...) {
-        return "\"<stringify error>\"";
+inline void MinJSON::StreamParser::complete_token() {
+    // Готовый токен разбирается теми же методами, что и в parse()
+    lexer_.text_ = token_;
+    lexer_.pos_ = 0;
+    
+    Result<Value> value;
+    if (mode_ == Mode::String) value = lexer_.parse_string();
+    else if (mode_ == Mode::Number) value = lexer_.parse_number();
+    else value = lexer_.parse_value();
+    
+    mode_ = Mode::Structure;
+    if (auto* err = std::get_if<Error>(&value)) {
+        fail(Error{err->code, token_start_ + err->offset});
+        return;
     }
+    if (lexer_.pos_ != token_.size()) {
+        fail(Error{Error::Code::UnexpectedCharacter, token_start_ + lexer_.pos_});
+        return;
+    }
+    
+    if (reading_key_) {
+        reading_key_ = false;
+        frames_.back().key = std::move(*std::any_cast<std::string>(&std::get<Value>(value)));
+        state_ = State::Colon;
+        return;
+    }
+    emit_value(std::get<Value>(std::move(value)));
 }
 
-// Доступ к данным
-inline std::vector<MinJSON::PathSegment> MinJSON::parse_path(std::string_view path) const {
-    std::string path_str(path);
-    if (auto it = path_cache_.find(path_str); it != path_cache_.end()) {
-        return it->second;
+inline void MinJSON::StreamParser::emit_value(Value value) {
+    if (frames_.empty()) {
+        root_ = std::move(value);
+        state_ = State::Done;
+        return;
     }
     
-    std::vector<PathSegment> segments;
+    auto& top = frames_.back();
+    if (top.is_object) {
+        top.object[std::move(top.key)] = std::move(value);
+        top.key.clear();
+    } else {
+        top.array.push(std::move(value));
+    }
+    state_ = State::CommaOrEnd;
+}
+
+inline void MinJSON::StreamParser::close_container() {
+    Frame frame = std::move(frames_.back());
+    frames_.pop_back();
+    
+    if (frame.is_object) {
+        emit_value(std::move(frame.object));
+    } else {
+        emit_value(frame.array.finish());
+    }
+}
+
+inline void MinJSON::StreamParser::fail(Error error) noexcept {
+    if (!error_) {
+        error_ = std::move(error);
+    }
+}
+
+// Доступ к данным
+template <typename OnKey, typename OnIndex>
+std::optional<MinJSON::Error> MinJSON::scan_path(std::string_view path, OnKey&& on_key, OnIndex&& on_index) {
     size_t start = 0;
     const size_t length = path.size();
     
     while (start < length) {
         if (path[start] == '[') {
             // Индекс массива
-            start++;
+            const size_t bracket = start++;
             size_t end = path.find(']', start);
             if (end == std::string::npos) {
-                throw std::runtime_error("Unclosed array index");
+                return Error{Error::Code::InvalidPath, bracket};
             }
             
             size_t index = 0;
@@ -473,22 +1901,21 @@ inline std::vector<MinJSON::PathSegment> MinJSON::parse_path(std::string_view pa
                 index
             );
             
-            if (result.ec != std::errc()) {
-                throw std::runtime_error("Invalid array index: " + std::string(path.substr(start, end - start)));
+            if (result.ec != std::errc() || result.ptr != path.data() + end) {
+                return Error{Error::Code::InvalidPath, start};
             }
             
-            segments.emplace_back(IndexSegment{index});
+            on_index(index, bracket);
             start = end + 1;
         } else {
             // Ключ объекта
-            size_t end = path.find('[', start);
+            size_t end = path.find_first_of(".[", start);
             if (end == std::string::npos) {
                 end = length;
             }
             
-            std::string key(path.substr(start, end - start));
-            if (!key.empty()) {
-                segments.emplace_back(KeySegment{std::move(key)});
+            if (end > start) {
+                on_key(path.substr(start, end - start), start);
             }
             start = end;
         }
@@ -498,38 +1925,75 @@ inline std::vector<MinJSON::PathSegment> MinJSON::parse_path(std::string_view pa
             start++;
         }
     }
+    return std::nullopt;
+}
+
+inline MinJSON::Result<const std::vector<MinJSON::PathSegment>*> MinJSON::parse_path(std::string_view path) const {
+    if (auto it = path_cache_.find(path); it != path_cache_.end()) {
+        return &it->second;
+    }
+    
+    // Сначала только проверка: ошибка в пути не должна выделять память
+    auto ignore = [](auto, size_t) noexcept {};
+    if (auto error = scan_path(path, ignore, ignore)) {
+        return *error;
+    }
+    
+    std::vector<PathSegment> segments;
+    (void)scan_path(
+        path,
+        [&](std::string_view key, size_t offset) { segments.emplace_back(KeySegment{std::string(key), offset}); },
+        [&](size_t index, size_t offset) { segments.emplace_back(IndexSegment{index, offset}); }
+    );
     
-    path_cache_[path_str] = segments;
-    return segments;
+    return &path_cache_.emplace(std::string(path), std::move(segments)).first->second;
 }
 
 inline const MinJSON::Value* MinJSON::traverse_path(
     const Value* current, 
-    const std::vector<PathSegment>& segments
+    const std::vector<PathSegment>& segments,
+    Value& element,
+    Error* error
 ) const noexcept {
+    // Причина и позиция в пути первого сегмента, который не удалось пройти
+    auto fail = [&](Error::Code code, size_t offset) -> const Value* {
+        if (error) *error = Error{code, offset};
+        return nullptr;
+    };
+    
+    // Элемент упакованного массива не хранится как Value — он копируется в element
+    auto packed_element = [&](const auto* packed, const IndexSegment& index) -> const Value* {
+        if (index.value >= packed->size()) return fail(Error::Code::IndexOutOfRange, index.offset);
+        element = (*packed)[index.value];
+        return &element;
+    };
+    
     for (const auto& segment : segments) {
-        if (!current) return nullptr;
-        
         if (auto key = std::get_if<KeySegment>(&segment)) {
             if (auto obj = std::any_cast<Object>(current)) {
                 if (auto it = obj->find(key->value); it != obj->end()) {
                     current = &it->second;
                 } else {
-                    return nullptr;
+                    return fail(Error::Code::PathNotFound, key->offset);
                 }
             } else {
-                return nullptr;
+                return fail(Error::Code::ExpectedObject, key->offset);
             }
         } else if (auto index = std::get_if<IndexSegment>(&segment)) {
             if (auto arr = std::any_cast<Array>(current)) {
                 if (index->value < arr->size()) {
                     current = &(*arr)[index->value];
                 } else {
-                    return nullptr;
+                    return fail(Error::Code::IndexOutOfRange, index->offset);
                 }
+            } else if (auto ints = std::any_cast<IntArray>(current)) {
+                current = packed_element(ints, *index);
+            } else if (auto doubles = std::any_cast<DoubleArray>(current)) {
+                current = packed_element(doubles, *index);
             } else {
-                return nullptr;
+                return fail(Error::Code::ExpectedArray, index->offset);
             }
+            if (!current) return nullptr;
         }
     }
     return current;
@@ -537,27 +2001,36 @@ inline const MinJSON::Value* MinJSON::traverse_path(
 
 inline const MinJSON::Value* MinJSON::find_value(
     const Value& root, 
-    std::string_view path
+    std::string_view path,
+    Value& element
 ) const noexcept {
     try {
         auto segments = parse_path(path);
-        return traverse_path(&root, segments);
+        if (std::holds_alternative<Error>(segments)) return nullptr;
+        return traverse_path(&root, *std::get<0>(segments), element);
     } catch (...) {
         return nullptr;
     }
 }
 
+inline std::optional<MinJSON::Array> MinJSON::unpack_array(const Value& value) {
+    if (const auto* arr = std::any_cast<Array>(&value)) return *arr;
+    if (const auto* ints = std::any_cast<IntArray>(&value)) return Array(ints->begin(), ints->end());
+    if (const auto* doubles = std::any_cast<DoubleArray>(&value)) return Array(doubles->begin(), doubles->end());
+    return std::nullopt;
+}
+
 template <MinJSONValueType T>
 T MinJSON::extract_value(const Value& value, const T& default_val) const noexcept {
     try {
-        if constexpr (detail::is_optional<T>::value) {
+        if constexpr (MinJSONDetail::is_optional<T>::value) {
             using ValueType = typename T::value_type;
             if (value.type() == typeid(std::nullptr_t)) {
                 return std::nullopt;
             }
             return extract_value<ValueType>(value, ValueType{});
         }
-        else if constexpr (detail::is_vector<T>::value) {
+        else if constexpr (MinJSONDetail::is_vector<T>::value) {
             using ElementType = typename T::value_type;
             if (const auto* arr = std::any_cast<Array>(&value)) {
                 T result;
@@ -567,6 +2040,22 @@ T MinJSON::extract_value(const Value& value, const T& default_val) const noexcep
                 }
                 return result;
             }
+            
+            auto from_packed = [&](const auto& packed) -> T {
+                if constexpr (std::is_arithmetic_v<ElementType>) {
+                    // Для совпадающего типа — копирование одним блоком
+                    return T(packed.begin(), packed.end());
+                } else {
+                    T result;
+                    result.reserve(packed.size());
+                    for (auto item : packed) {
+                        result.push_back(extract_value<ElementType>(Value(item), ElementType{}));
+                    }
+                    return result;
+                }
+            };
+            if (const auto* p = std::any_cast<IntArray>(&value)) return from_packed(*p);
+            if (const auto* p = std::any_cast<DoubleArray>(&value)) return from_packed(*p);
             return default_val;
         }
         else if constexpr (std::same_as<T, std::string>) {
@@ -601,7 +2090,8 @@ T MinJSON::extract_value(const Value& value, const T& default_val) const noexcep
 
 template <MinJSONValueType T>
 T MinJSON::get(const Value& root, std::string_view path, const T& default_val) const noexcept {
-    if (auto value = find_value(root, path)) {
+    Value element;
+    if (auto value = find_value(root, path, element)) {
         return extract_value<T>(*value, default_val);
     }
     return default_val;
@@ -609,14 +2099,31 @@ T MinJSON::get(const Value& root, std::string_view path, const T& default_val) c
 
 template <MinJSONValueType T>
 MinJSON::Result<T> MinJSON::get_checked(const Value& root, std::string_view path) const noexcept {
-    if (auto value = find_value(root, path)) {
-        try {
+    try {
+        auto segments = parse_path(path);
+        if (auto* err = std::get_if<Error>(&segments)) return *err;
+        
+        Value element;
+        Error error{Error::Code::PathNotFound, 0};
+        if (auto value = traverse_path(&root, *std::get<0>(segments), element, &error)) {
             return extract_value<T>(*value, T{});
-        } catch (const std::exception& e) {
-            return Error(e.what());
+        }
+        return error;
+    } catch (...) {
+        return Error{Error::Code::Internal, 0};
+    }
+}
+
+template <typename T>
+    requires std::same_as<T, int> || std::same_as<T, double>
+std::span<const T> MinJSON::get_span(const Value& root, std::string_view path) const noexcept {
+    Value element;
+    if (auto value = find_value(root, path, element)) {
+        if (const auto* packed = std::any_cast<std::vector<T>>(value)) {
+            return *packed;
         }
     }
-    return Error("Path not found: " + std::string(path));
+    return {};
 }
 
 inline std::optional<MinJSON::Error> MinJSON::set(
@@ -625,7 +2132,10 @@ inline std::optional<MinJSON::Error> MinJSON::set(
     Value value
 ) noexcept {
     try {
-        auto segments = parse_path(path);
+        auto parsed = parse_path(path);
+        if (auto* err = std::get_if<Error>(&parsed)) return *err;
+        
+        const auto& segments = *std::get<0>(parsed);
         if (segments.empty()) {
             root = std::move(value);
             return std::nullopt;
@@ -635,18 +2145,19 @@ inline std::optional<MinJSON::Error> MinJSON::set(
         for (size_t i = 0; i < segments.size(); ++i) {
             const bool last = (i == segments.size() - 1);
             
-            std::visit([&](auto&& seg) {
+            auto err = std::visit([&](auto&& seg) {
                 handle_segment(*current, seg, last);
-                advance(current, seg);
+                return advance(current, seg);
             }, segments[i]);
+            if (err) return err;
 
             if (last) {
                 *current = std::move(value);
             }
         }
         return std::nullopt;
-    } catch (const std::exception& e) {
-        return Error(e.what());
+    } catch (...) {
+        return Error{Error::Code::Internal, 0};
     }
 }
 
@@ -706,6 +2217,9 @@ inline void MinJSON::handle_segment(Value& node, const KeySegment& seg, bool is_
 }
 
 inline void MinJSON::handle_segment(Value& node, const IndexSegment& seg, bool is_last) {
+    if (node.type() == typeid(IntArray) || node.type() == typeid(DoubleArray)) {
+        node = *unpack_array(node);
+    }
     if (!node.has_value() || node.type() != typeid(Array)) {
         node = Array{};
     }
@@ -720,24 +2234,26 @@ inline void MinJSON::handle_segment(Value& node, const IndexSegment& seg, bool i
     }
 }
 
-inline void MinJSON::advance(Value*& current, const KeySegment& seg) {
+inline std::optional<MinJSON::Error> MinJSON::advance(Value*& current, const KeySegment& seg) noexcept {
     if (auto obj = std::any_cast<Object>(current)) {
-        current = &(*obj)[seg.value];
-    } else {
-        throw std::runtime_error("Expected object at: " + seg.value);
+        if (auto it = obj->find(seg.value); it != obj->end()) {
+            current = &it->second;
+            return std::nullopt;
+        }
+        return Error{Error::Code::PathNotFound, seg.offset};
     }
+    return Error{Error::Code::ExpectedObject, seg.offset};
 }
 
-inline void MinJSON::advance(Value*& current, const IndexSegment& seg) {
+inline std::optional<MinJSON::Error> MinJSON::advance(Value*& current, const IndexSegment& seg) noexcept {
     if (auto arr = std::any_cast<Array>(current)) {
         if (seg.value < arr->size()) {
             current = &(*arr)[seg.value];
-        } else {
-            throw std::runtime_error("Index out of range: " + std::to_string(seg.value));
+            return std::nullopt;
         }
-    } else {
-        throw std::runtime_error("Expected array at index: " + std::to_string(seg.value));
+        return Error{Error::Code::IndexOutOfRange, seg.offset};
     }
+    return Error{Error::Code::ExpectedArray, seg.offset};
 }
 
 // Реализация рефлексии через макросы
@@ -766,4 +2282,4 @@ static void MINJSON_register_##TYPE(MinJSON& json) { \
     result[#FIELD] = MinJSON::to_json(obj.FIELD); \
     if (auto it = obj_map.find(#FIELD); it != obj_map.end()) { \
         obj.FIELD = MinJSON::from_json<std::remove_reference_t<decltype(obj.FIELD)>>(it->second); \
-    }
\ No newline at end of file
+    }
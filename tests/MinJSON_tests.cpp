@@ -0,0 +1,334 @@
+#include "MinJSON.hpp"
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "FAILED: " << what << "\n";
+    }
+}
+
+bool is_error(const MinJSON::Result<MinJSON::Value>& result) {
+    return std::holds_alternative<MinJSON::Error>(result);
+}
+
+void test_parse() {
+    MinJSON json;
+    auto result = json.parse(R"({"name":"Alice","tags":["a","b"],"n":null})");
+    check(!is_error(result), "parse: document with strings");
+    if (is_error(result)) return;
+
+    const auto& data = std::get<MinJSON::Value>(result);
+    check(json.get<std::string>(data, "name") == "Alice", "parse: string value");
+    check(json.get<std::string>(data, "tags[1]") == "b", "parse: string in array");
+    check(!json.get<std::optional<int>>(data, "n").has_value(), "parse: null value");
+
+    check(!is_error(json.parse(" [1, 2] \n")), "parse: trailing whitespace");
+    check(is_error(json.parse("[1, 2] x")), "parse: trailing characters");
+}
+
+void test_stream_parser() {
+    MinJSON json;
+    const std::string doc =
+        R"( {"items":[{"name":"ap\"pleA"},{"name":"banana","n":-12,"d":1.5e3,)"
+        R"("b":true,"z":null,"f":false}],"e":[],"o":{}} )";
+    const auto whole = json.parse(doc);
+    check(!is_error(whole), "stream: reference parse");
+    if (is_error(whole)) return;
+    const auto expected = json.stringify(std::get<MinJSON::Value>(whole));
+
+    // Результат не должен зависеть от того, как документ разбит на фрагменты
+    for (size_t step = 1; step <= doc.size(); ++step) {
+        MinJSON::StreamParser parser;
+        bool fed = true;
+        for (size_t i = 0; i < doc.size(); i += step) {
+            fed = fed && !parser.feed(std::string_view(doc).substr(i, step));
+        }
+        auto result = parser.finish();
+        check(fed && !is_error(result), "stream: chunked feed");
+        if (!is_error(result)) {
+            check(json.stringify(std::get<MinJSON::Value>(result)) == expected, "stream: same document as parse()");
+        }
+    }
+
+    MinJSON::StreamParser parser;
+    (void)parser.feed("4");
+    (void)parser.feed("2");
+    auto number = parser.finish();
+    check(!is_error(number) && std::any_cast<int>(std::get<MinJSON::Value>(number)) == 42,
+          "stream: number split across chunks");
+
+    (void)parser.feed(R"("hel)");
+    (void)parser.feed(R"(lo")");
+    auto text = parser.finish();
+    check(!is_error(text) && std::any_cast<std::string>(std::get<MinJSON::Value>(text)) == "hello",
+          "stream: string split across chunks");
+
+    for (std::string_view bad : {"[1,]", R"({"a" 1})", "[1 2]", "nul", "[true", R"("abc)", "truex", "[1,2] x", "{,}"}) {
+        (void)parser.feed(bad);
+        check(is_error(parser.finish()), "stream: rejects malformed input");
+        check(is_error(json.parse(bad)), "parse: rejects malformed input");
+    }
+}
+
+void test_schema() {
+    MinJSON json;
+    auto schema_doc = json.parse(R"({
+        "type": "object",
+        "required": ["id", "tags"],
+        "properties": {
+            "id": {"type": "integer", "minimum": 1},
+            "tags": {"type": "array", "maxItems": 2, "items": {"type": "string", "pattern": "^(a|b)*$"}}
+        }
+    })");
+    check(!is_error(schema_doc), "schema: parse schema document");
+    if (is_error(schema_doc)) return;
+    auto compiled = json.compile_schema(std::get<MinJSON::Value>(schema_doc));
+    check(std::holds_alternative<MinJSON::Schema>(compiled), "schema: compile");
+    if (!std::holds_alternative<MinJSON::Schema>(compiled)) return;
+    const auto& schema = std::get<MinJSON::Schema>(compiled);
+
+    auto code_of = [&](std::string_view input) {
+        auto result = json.parse(input, schema);
+        return is_error(result) ? std::get<MinJSON::Error>(result).code : MinJSON::Error::Code::Internal;
+    };
+
+    check(!is_error(json.parse(R"({"id": 3, "tags": ["ab", "ba"]})", schema)), "schema: accepts valid document");
+    check(code_of(R"({"id": 0, "tags": []})") == MinJSON::Error::Code::SchemaMinimum, "schema: minimum");
+    check(code_of(R"({"id": "x", "tags": []})") == MinJSON::Error::Code::SchemaType, "schema: type");
+    check(code_of(R"({"id": 1})") == MinJSON::Error::Code::SchemaRequired, "schema: required");
+    check(code_of(R"({"id": 1, "tags": ["a", "b", "a"]})") == MinJSON::Error::Code::SchemaMaxItems, "schema: maxItems");
+    check(code_of(R"({"id": 1, "tags": ["abc"]})") == MinJSON::Error::Code::SchemaPattern, "schema: pattern");
+    check(code_of(R"({"id": 1, "tags": []} x)") == MinJSON::Error::Code::TrailingCharacters,
+          "schema: trailing characters");
+
+    // Длинная строка не должна переполнять стек рекурсивного сопоставителя
+    const std::string long_tag = R"({"id": 1, "tags": [")" + std::string(200 * 1024, 'a') + R"("]})";
+    check(code_of(long_tag) == MinJSON::Error::Code::SchemaPatternInputTooLong, "schema: long pattern input");
+    check(!is_error(json.parse(R"({"id": 1, "tags": [")" + std::string(2000, 'a') + R"("]})", schema)),
+          "schema: pattern input below the limit");
+
+    auto relaxed = json.compile_schema(std::get<MinJSON::Value>(schema_doc), 100, true);
+    if (std::holds_alternative<MinJSON::Schema>(relaxed)) {
+        const auto& skipping = std::get<MinJSON::Schema>(relaxed);
+        check(!is_error(json.parse(long_tag, skipping)), "schema: long pattern input skipped on request");
+        check(is_error(json.parse(R"({"id": 1, "tags": ["abc"]})", skipping)), "schema: short input still checked");
+    }
+    auto strict = json.compile_schema(std::get<MinJSON::Value>(schema_doc), 100);
+    if (std::holds_alternative<MinJSON::Schema>(strict)) {
+        check(is_error(json.parse(R"({"id": 1, "tags": [")" + std::string(200, 'a') + R"("]})",
+                                  std::get<MinJSON::Schema>(strict))),
+              "schema: custom pattern input limit");
+    }
+}
+
+void test_packed_arrays() {
+    MinJSON json;
+    auto result = json.parse(R"({"ints":[1,2,3],"doubles":[0.5,-1.25],"mixed":[0.1,0,-0.3],"other":[1,2.5,"x"]})");
+    check(!is_error(result), "packed: parse");
+    if (is_error(result)) return;
+    auto data = std::get<MinJSON::Value>(result);
+
+    auto ints = json.get_span<int>(data, "ints");
+    check(ints.size() == 3 && ints[2] == 3, "packed: int span");
+    check(json.get_span<double>(data, "ints").empty(), "packed: no double span over ints");
+    auto doubles = json.get_span<double>(data, "doubles");
+    check(doubles.size() == 2 && doubles[1] == -1.25, "packed: double span");
+    check(json.get<std::vector<double>>(data, "doubles") == std::vector<double>{0.5, -1.25}, "packed: vector copy");
+    check(json.get<int>(data, "ints[1]") == 2, "packed: index access");
+
+    // Целые среди дробных хранятся как double, массив остаётся упакованным
+    auto mixed = json.get_span<double>(data, "mixed");
+    check(mixed.size() == 3 && mixed[1] == 0.0 && mixed[2] == -0.3, "packed: ints in a double array");
+    check(json.get<int>(data, "mixed[1]") == 0, "packed: int access to a double array");
+
+    // Нечисловой элемент переводит массив в Array, числа сохраняют исходные типы
+    check(json.get_span<double>(data, "other").empty(), "packed: generic fallback");
+    check(json.stringify(std::any_cast<const MinJSON::Object&>(data).at("other")) == R"([1,2.500000,"x"])",
+          "packed: generic fallback keeps ints");
+
+    check(!json.set(data, "ints[0]", std::string("a")), "packed: set unpacks");
+    check(json.get<std::string>(data, "ints[0]") == "a" && json.get<int>(data, "ints[2]") == 3,
+          "packed: set keeps other elements");
+}
+
+void test_error_offsets() {
+    using Code = MinJSON::Error::Code;
+    MinJSON json;
+
+    const std::string_view input = "{\"a\": [1,\n 2 3]}";
+    auto result = json.parse(input);
+    check(is_error(result), "errors: malformed document");
+    if (is_error(result)) {
+        const auto& error = std::get<MinJSON::Error>(result);
+        check(error.code == Code::ExpectedArrayDelimiter && error.offset == 13, "errors: parse offset");
+        const auto location = error.location(input);
+        check(location.line == 2 && location.column == 4, "errors: line and column");
+    }
+
+    auto parsed = json.parse(R"({"user":{"tags":[1,2]},"n":5})");
+    check(!is_error(parsed), "errors: parse document");
+    if (is_error(parsed)) return;
+    auto data = std::get<MinJSON::Value>(parsed);
+
+    auto error_of = [](const auto& checked) {
+        return std::holds_alternative<MinJSON::Error>(checked) ? std::get<MinJSON::Error>(checked) : MinJSON::Error{};
+    };
+    check(error_of(json.get_checked<int>(data, "user.tags[5]")) == MinJSON::Error{Code::IndexOutOfRange, 9},
+          "errors: index out of range offset");
+    check(error_of(json.get_checked<int>(data, "user.name")) == MinJSON::Error{Code::PathNotFound, 5},
+          "errors: missing key offset");
+    check(error_of(json.get_checked<int>(data, "n.x")) == MinJSON::Error{Code::ExpectedObject, 2},
+          "errors: expected object offset");
+    check(error_of(json.get_checked<int>(data, "user[0]")) == MinJSON::Error{Code::ExpectedArray, 4},
+          "errors: expected array offset");
+    check(error_of(json.get_checked<int>(data, "user.tags[1x]")) == MinJSON::Error{Code::InvalidPath, 10},
+          "errors: invalid path offset");
+    check(json.set(data, "user.tags[", 1) == MinJSON::Error{Code::InvalidPath, 9}, "errors: set with invalid path");
+    check(!json.set(data, "user.tags[3]", 4) && json.get<int>(data, "user.tags[3]") == 4, "errors: set extends array");
+}
+
+void test_parallel() {
+    MinJSON json;
+    auto same_as_sequential = [&](const std::string& input, std::string_view what) {
+        const auto sequential = json.parse(input);
+        const auto parallel = json.parse_parallel(input, 4);
+        check(!is_error(sequential) && !is_error(parallel), what);
+        if (is_error(sequential) || is_error(parallel)) return;
+        check(json.stringify(std::get<MinJSON::Value>(sequential)) == json.stringify(std::get<MinJSON::Value>(parallel)),
+              what);
+    };
+
+    // Документы больше нескольких parallel_min_range_, чтобы разбор действительно шёл в потоках
+    constexpr size_t count = 600'000;
+    std::string ints = "[";
+    std::string doubles = "[";
+    std::string strings = "[";
+    for (size_t i = 0; i < count; ++i) {
+        const char* sep = i ? "," : "";
+        ints += sep + std::to_string(i % 1000);
+        doubles += sep + std::to_string(i % 1000) + ".5";
+        strings += sep + std::string(R"("a,\"]b")");
+    }
+    same_as_sequential(ints + "]", "parallel: int array");
+    same_as_sequential(doubles + "]", "parallel: double array");
+    same_as_sequential(ints + "," + doubles.substr(1) + "]", "parallel: ints promoted to doubles");
+    same_as_sequential(strings + "]", "parallel: strings with commas and brackets");
+
+    const std::string mixed = "[1,2.5," + ints.substr(1) + R"(,"x"])";
+    same_as_sequential(mixed, "parallel: mixed array");
+    auto mixed_result = json.parse_parallel(mixed, 4);
+    if (!is_error(mixed_result)) {
+        const auto& data = std::get<MinJSON::Value>(mixed_result);
+        check(json.get_checked<int>(data, "[0]") == MinJSON::Result<int>(1), "parallel: mixed array keeps ints");
+        check(json.get<double>(data, "[1]") == 2.5, "parallel: mixed array keeps doubles");
+    }
+
+    std::string object = "{";
+    for (size_t i = 0; i < count / 4; ++i) {
+        object += (i ? ",\"k" : "\"k") + std::to_string(i) + R"(":{"v":[)" + std::to_string(i) + "]}";
+    }
+    object += "}";
+    auto object_result = json.parse_parallel(object, 4);
+    check(!is_error(object_result), "parallel: object");
+    if (!is_error(object_result)) {
+        const auto& data = std::get<MinJSON::Value>(object_result);
+        check(std::any_cast<const MinJSON::Object&>(data).size() == count / 4, "parallel: object size");
+        check(json.get<int>(data, "k12345.v[0]") == 12345, "parallel: object member");
+    }
+
+    check(is_error(json.parse_parallel(ints + "] x", 4)), "parallel: trailing characters");
+    check(is_error(json.parse_parallel("[1] x", 4)), "parallel: trailing characters on small input");
+    std::string broken = ints + "]";
+    broken[broken.size() / 2] = ':';
+    check(is_error(json.parse_parallel(broken, 4)), "parallel: error inside a range");
+}
+
+void test_projection() {
+    MinJSON json;
+    auto compiled = json.compile_projection({"user.id", "items[*].sku", "pair[1]"});
+    check(std::holds_alternative<MinJSON::Projection>(compiled), "projection: compile");
+    if (!std::holds_alternative<MinJSON::Projection>(compiled)) return;
+    const auto& projection = std::get<MinJSON::Projection>(compiled);
+
+    auto result = json.parse(R"({
+        "user": {"id": 7, "name": "Bob", "tags": [1, 2, {"x": [3]}]},
+        "items": [{"sku": "a", "qty": 1}, {"qty": 2}, 5, {"sku": "c"}],
+        "pair": [{"skip": true}, "kept"],
+        "other": {"deep": [1, 2, 3]}
+    })", projection);
+    check(!is_error(result), "projection: parse");
+    if (is_error(result)) return;
+    const auto& data = std::get<MinJSON::Value>(result);
+    const auto& root = std::any_cast<const MinJSON::Object&>(data);
+
+    check(json.get<int>(data, "user.id") == 7, "projection: requested key");
+    check(std::holds_alternative<MinJSON::Error>(json.get_checked<std::string>(data, "user.name")),
+          "projection: skipped key");
+    check(!root.contains("other"), "projection: skipped member");
+    check(json.get<std::string>(data, "items[0].sku") == "a", "projection: wildcard element");
+    check(json.get<std::string>(data, "items[3].sku") == "c", "projection: indices are preserved");
+    check(json.get_checked<std::optional<int>>(data, "items[2]") == MinJSON::Result<std::optional<int>>(std::nullopt),
+          "projection: mismatched element becomes null");
+    check(json.get_checked<std::optional<int>>(data, "pair[0]") == MinJSON::Result<std::optional<int>>(std::nullopt),
+          "projection: skipped element becomes null");
+    check(json.get<std::string>(data, "pair[1]") == "kept", "projection: requested index");
+
+    // Контейнер не того вида отбрасывается так же, как скаляр
+    auto mismatched = json.parse(R"({"user": [1], "items": {"sku": "a"}})", projection);
+    check(!is_error(mismatched) && std::any_cast<const MinJSON::Object&>(std::get<MinJSON::Value>(mismatched)).empty(),
+          "projection: mismatched containers are dropped");
+
+    check(is_error(json.parse(R"({"user": {"id": 1}} x)", projection)), "projection: trailing characters");
+
+    // Корень не того вида даёт пустой контейнер, а не пустой std::any
+    auto root_mismatch = json.parse("[1, 2]", projection);
+    check(!is_error(root_mismatch) && std::get<MinJSON::Value>(root_mismatch).type() == typeid(MinJSON::Object) &&
+              std::any_cast<const MinJSON::Object&>(std::get<MinJSON::Value>(root_mismatch)).empty(),
+          "projection: mismatched root");
+    auto by_index = json.compile_projection({"[0]"});
+    if (std::holds_alternative<MinJSON::Projection>(by_index)) {
+        auto array_root = json.parse(R"({"a": 1})", std::get<MinJSON::Projection>(by_index));
+        check(!is_error(array_root) && std::get<MinJSON::Value>(array_root).type() == typeid(MinJSON::Array),
+              "projection: mismatched root of an array projection");
+    }
+
+    // Пропускаемые поддеревья проверяются только на парность скобок
+    auto only_a = std::get<MinJSON::Projection>(json.compile_projection({"a"}));
+    check(is_error(json.parse(R"({"b":[}, "a":1})", only_a)), "projection: mismatched brackets in skipped value");
+    check(is_error(json.parse(R"({"b":{"x":[1}]}, "a":1})", only_a)), "projection: nested mismatched brackets");
+    check(is_error(json.parse(R"({"b":[1, "a":1})", only_a)), "projection: unclosed skipped value");
+    check(!is_error(json.parse(R"({"b":{,,,}, "a":1})", only_a)), "projection: skipped value is not fully validated");
+    check(!is_error(json.parse(R"({"b":{"x": tru}, "a":1})", only_a)), "projection: skipped literal is not validated");
+    check(is_error(json.parse(R"({"b":{,,,}, "a":1})")), "projection: parse() still rejects it");
+
+    // Глубже skip_max_depth_ поддерево разбирается полностью
+    const std::string deep = std::string(1500, '[') + std::string(1500, ']');
+    check(!is_error(json.parse(R"({"b":)" + deep + R"(, "a":1})", only_a)), "projection: deep skipped value");
+    check(is_error(json.parse(R"({"b":)" + std::string(1500, '[') + "}" + std::string(1499, ']') + R"(, "a":1})", only_a)),
+          "projection: deep skipped value with mismatched brackets");
+}
+
+} // namespace
+
+int main() {
+    test_parse();
+    test_stream_parser();
+    test_schema();
+    test_packed_arrays();
+    test_error_offsets();
+    test_parallel();
+    test_projection();
+
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All tests passed\n";
+}